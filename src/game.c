@@ -1,6 +1,8 @@
 #include <pebble.h>
 #include "game.h"
 #include "debrief.h"
+#include "sync.h"
+#include "memstats.h"
 
 #define SNAKE_BODY_WIDTH 5
 #define SNAKE_BODY_SPACING 0
@@ -39,6 +41,7 @@ typedef struct game_state_t {
     unsigned score;
     unsigned bonus_points; // Bonus points decreases the longer the user takes to eat the apple
     unsigned queued_input; // 0 - Nothing, 1 - Up, 2 - Down, 3 - Pause
+    unsigned ticks; // Unpaused game ticks since setup
 } game_state_t;
 
 static Window *game_window;
@@ -75,7 +78,7 @@ int round_to_nearest_multiple(int number, int multiple)
 
 static void add_to_head(snake_t *snake)
 {
-	snake_section_t *new_head = malloc(sizeof(snake_section_t));
+	snake_section_t *new_head = memstats_malloc(sizeof(snake_section_t));
     snake_section_t *current_head = snake->head;
     switch (snake->direction) {
         case 1:
@@ -141,15 +144,15 @@ static void move_snake(snake_t *snake)
     while (next_section->next != NULL) {
         current_section = next_section;
         next_section = next_section->next;
-        // Check collision
+        // Check collision, but keep walking to the tail so
+        // only the last section is unlinked and freed below
         if (current_section->x == head_x && current_section->y == head_y) {
             collided = 1;
-            break;
         }
     }
     // remove last section
     current_section->next = NULL;
-    free(next_section);
+    memstats_free(next_section);
     
     // Mark game as dead if the snake collided
     if (collided) {
@@ -166,7 +169,7 @@ static unsigned snake_has_eaten_apple(snake_t *snake, apple_t *apple)
 
 static void move_apple()
 {
-    srand(time(NULL));
+    memstats_enter_move_apple();
     int random = rand();
 
     apple->x = round_to_nearest_multiple(random % (int)(container_width - 2*SNAKE_BODY_WIDTH), APPLE_SIZE);
@@ -188,6 +191,7 @@ static void move_apple()
     if (is_bad_placement) {
         move_apple();
     }
+    memstats_leave_move_apple();
 }
 
 //--------------------------------------------- 
@@ -197,8 +201,11 @@ static void move_apple()
 static void game_end(unsigned finished)
 {
     if (finished) {
+        sync_end_game(game->score, snake->length, game->ticks*GAME_TICK_INTERVAL);
+        sync_set_game_running(false);
         vibes_double_pulse();
         debrief_user_with_score(game->score);
+        memstats_report("debrief");
         game->is_resetting = 1;
     }
 }
@@ -207,20 +214,20 @@ static void game_setup()
 {
     if (!game) {
         // Make a NEW game
-        game = malloc(sizeof(game_state_t));
+        game = memstats_malloc(sizeof(game_state_t));
         
         // Make a head for a snake
-        snake_section_t *head = malloc(sizeof(snake_section_t));
+        snake_section_t *head = memstats_malloc(sizeof(snake_section_t));
         head->x = SNAKE_BODY_WIDTH;
         head->y = SNAKE_BODY_WIDTH;
         head->next = NULL;
         
         // Make a snake with that head
-        snake = malloc(sizeof(snake_t));
+        snake = memstats_malloc(sizeof(snake_t));
         snake->head = head;
         
         // Make an apple
-        apple = malloc(sizeof(apple_t));
+        apple = memstats_malloc(sizeof(apple_t));
         
     } else if (game->is_resetting) {
         // Resets the snake
@@ -231,7 +238,7 @@ static void game_setup()
         while(current_section) {
             next = current_section;
             current_section = current_section->next;
-            free(next);
+            memstats_free(next);
         }
         current_head->x = SNAKE_BODY_WIDTH;
         current_head->y = SNAKE_BODY_WIDTH;
@@ -245,6 +252,8 @@ static void game_setup()
     snake->direction = 0;
     game->is_resetting = 0;
     game->bonus_points = 0;
+    game->ticks = 0;
+    sync_begin_game();
     
     // Make the snake as long as the default size
     for (int i = 1; i < DEFAULT_SNAKE_SIZE; ++i) {
@@ -254,6 +263,7 @@ static void game_setup()
 
     // Move apple to random location
     move_apple();
+    memstats_report("game_setup");
 }
 
 static void bonus_timer_callback(void *data)
@@ -279,8 +289,12 @@ static void game_tick(void *data)
         return;
     }
 
+    // Only unpaused ticks count towards the game's duration
+    game->ticks += 1;
+
     // Check User Input
     if (game->queued_input) {
+        sync_log_input(game->ticks, game->queued_input);
         switch (game->queued_input) {
             case 1:
                 // Up pressed, TURN COUNTERCLOCKWISE
@@ -318,6 +332,7 @@ static void game_tick(void *data)
         move_apple();
         game->score += (1 + game->bonus_points);
         snake->length += 1;
+        memstats_sample();
         vibes_short_pulse();
 
         if (game->bonus_points == 0) {
@@ -354,6 +369,7 @@ static void game_tick(void *data)
 static void game_start()
 {
     game_setup();
+    sync_set_game_running(true);
     game_timer = app_timer_register(GAME_TICK_INTERVAL, game_tick, NULL);
 }
 
@@ -441,6 +457,7 @@ static void window_disappear(Window *window) {
     if (game) {
         game->is_resetting = 1;
     }
+    sync_set_game_running(false);
 }
 
 static void window_unload(Window *window) {
@@ -455,6 +472,10 @@ static void window_unload(Window *window) {
 //---------------------------------------------
 
 void game_init(void) {
+    // Seeded once; reseeding per placement repeats the same spot
+    // within a second, so move_apple() would recurse until it changed
+    srand(time(NULL));
+
     game_window = window_create();
     window_set_click_config_provider(game_window, click_config_provider);
     window_set_window_handlers(game_window, (WindowHandlers) {
@@ -470,8 +491,17 @@ void game_init(void) {
 }
 
 void game_deinit(void) {
-    free(game);
-    free(snake);
-    free(apple);
+    if (snake) {
+        snake_section_t *current_section = snake->head;
+        snake_section_t *next;
+        while (current_section) {
+            next = current_section->next;
+            memstats_free(current_section);
+            current_section = next;
+        }
+    }
+    memstats_free(game);
+    memstats_free(snake);
+    memstats_free(apple);
     window_destroy(game_window);
 }
@@ -0,0 +1,76 @@
+// Receives finished game records batched by src/sync.c and keeps
+// a history of them in localStorage.
+
+var HISTORY_KEY = 'snakey.games';
+var HISTORY_MAX = 100;
+var RECORD_HEADER_SIZE = 8;
+var FLAG_LOG_TRUNCATED = 0x01;
+
+function readU16(bytes, offset) {
+    return bytes[offset] | (bytes[offset + 1] << 8);
+}
+
+// Mirrors the wire format documented in sync.c
+function decodeRecords(bytes) {
+    var records = [];
+    var offset = 0;
+    while (offset + RECORD_HEADER_SIZE <= bytes.length) {
+        var record = {
+            score: readU16(bytes, offset),
+            length: readU16(bytes, offset + 2),
+            duration: readU16(bytes, offset + 4),
+            logTruncated: (bytes[offset + 6] & FLAG_LOG_TRUNCATED) !== 0,
+            inputs: []
+        };
+        var logCount = bytes[offset + 7];
+        offset += RECORD_HEADER_SIZE;
+
+        var tick = 0;
+        for (var i = 0; i < logCount && offset + 2 <= bytes.length; ++i) {
+            var entry = readU16(bytes, offset);
+            offset += 2;
+            tick += entry & 0x3FFF;
+            if (entry >> 14) {
+                record.inputs.push({ tick: tick, input: entry >> 14 });
+            }
+        }
+        records.push(record);
+    }
+    return records;
+}
+
+function loadHistory() {
+    try {
+        return JSON.parse(localStorage.getItem(HISTORY_KEY)) || [];
+    } catch (e) {
+        return [];
+    }
+}
+
+function saveHistory(history) {
+    localStorage.setItem(HISTORY_KEY, JSON.stringify(history.slice(-HISTORY_MAX)));
+}
+
+Pebble.addEventListener('ready', function(e) {
+    console.log('Snakey companion ready, ' + loadHistory().length + ' games stored');
+});
+
+Pebble.addEventListener('appmessage', function(e) {
+    var bytes = e.payload.GAME_RECORDS;
+    if (!bytes) {
+        return;
+    }
+
+    var records = decodeRecords(bytes);
+    if (records.length !== e.payload.GAME_RECORD_COUNT) {
+        console.log('Expected ' + e.payload.GAME_RECORD_COUNT + ' game records, decoded ' + records.length);
+    }
+
+    var now = Date.now();
+    var history = loadHistory();
+    for (var i = 0; i < records.length; ++i) {
+        records[i].received = now;
+        history.push(records[i]);
+    }
+    saveHistory(history);
+});
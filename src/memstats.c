@@ -0,0 +1,111 @@
+#include <pebble.h>
+#include "memstats.h"
+
+#ifdef SNAKEY_HOST_BUILD
+// Host builds fail outright so a regression cannot ship
+#define MEMSTATS_CHECK(cond, what, value, budget, reported) \
+    do { \
+        if (!(cond)) { \
+            reported = true; \
+            APP_LOG(APP_LOG_LEVEL_ERROR, "Memory budget exceeded: %s %u > %u", what, (unsigned)(value), (unsigned)(budget)); \
+            abort(); \
+        } \
+    } while (0)
+#else
+// High-water marks never come back down, so each overrun is logged once
+#define MEMSTATS_CHECK(cond, what, value, budget, reported) \
+    do { \
+        if (!(cond) && !(reported)) { \
+            reported = true; \
+            APP_LOG(APP_LOG_LEVEL_ERROR, "Memory budget exceeded: %s %u > %u", what, (unsigned)(value), (unsigned)(budget)); \
+        } \
+    } while (0)
+#endif
+
+static unsigned live_allocs;
+static unsigned max_live_allocs;
+static size_t max_heap_used;
+static size_t min_heap_free = SIZE_MAX;
+
+static unsigned apple_depth;
+static unsigned max_apple_depth;
+
+static bool heap_size_reported;
+static bool heap_used_reported;
+static bool live_allocs_reported;
+static bool apple_depth_reported;
+
+//---------------------------------------------
+// Allocation Tracking
+//---------------------------------------------
+
+void *memstats_malloc(size_t size)
+{
+    void *ptr = malloc(size);
+    if (ptr) {
+        live_allocs += 1;
+        if (live_allocs > max_live_allocs) {
+            max_live_allocs = live_allocs;
+        }
+    }
+    return ptr;
+}
+
+void memstats_free(void *ptr)
+{
+    if (ptr) {
+        live_allocs -= 1;
+    }
+    free(ptr);
+}
+
+//---------------------------------------------
+// Recursion Tracking
+//---------------------------------------------
+
+void memstats_enter_move_apple(void)
+{
+    apple_depth += 1;
+    if (apple_depth > max_apple_depth) {
+        max_apple_depth = apple_depth;
+    }
+}
+
+void memstats_leave_move_apple(void)
+{
+    apple_depth -= 1;
+}
+
+//---------------------------------------------
+// Sampling
+//---------------------------------------------
+
+void memstats_sample(void)
+{
+    size_t used = heap_bytes_used();
+    size_t free_bytes = heap_bytes_free();
+    if (used > max_heap_used) {
+        max_heap_used = used;
+    }
+    if (free_bytes < min_heap_free) {
+        min_heap_free = free_bytes;
+    }
+
+    size_t heap_size = used + free_bytes;
+    MEMSTATS_CHECK(MEMSTATS_HEAP_USED_BUDGET <= heap_size, "heap budget vs heap size", MEMSTATS_HEAP_USED_BUDGET, heap_size, heap_size_reported);
+    MEMSTATS_CHECK(max_heap_used <= MEMSTATS_HEAP_USED_BUDGET, "heap used", max_heap_used, MEMSTATS_HEAP_USED_BUDGET, heap_used_reported);
+    MEMSTATS_CHECK(max_live_allocs <= MEMSTATS_LIVE_ALLOCS_BUDGET, "live allocs", max_live_allocs, MEMSTATS_LIVE_ALLOCS_BUDGET, live_allocs_reported);
+    MEMSTATS_CHECK(max_apple_depth <= MEMSTATS_APPLE_DEPTH_BUDGET, "move_apple depth", max_apple_depth, MEMSTATS_APPLE_DEPTH_BUDGET, apple_depth_reported);
+}
+
+void memstats_report(const char *label)
+{
+    memstats_sample();
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "mem %s: heap %u used %u (max %u) free %u (min %u) allocs %u (max %u) apple depth max %u",
+            label,
+            (unsigned)(heap_bytes_used() + heap_bytes_free()),
+            (unsigned)heap_bytes_used(), (unsigned)max_heap_used,
+            (unsigned)heap_bytes_free(), (unsigned)min_heap_free,
+            live_allocs, max_live_allocs,
+            max_apple_depth);
+}
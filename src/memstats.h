@@ -0,0 +1,39 @@
+#pragma once
+
+#include <pebble.h>
+
+// Budgets checked at every sample. Building with SNAKEY_HOST_BUILD
+// (see test/Makefile) makes an overrun abort instead of just logging,
+// and lets the host tests pass tighter budgets for their scenario.
+
+// The 144x152 play area holds at most 15x16 = 240 snake sections on
+// their 10px grid, plus the game, snake and apple allocations
+#ifndef MEMSTATS_LIVE_ALLOCS_BUDGET
+#define MEMSTATS_LIVE_ALLOCS_BUDGET 256
+#endif
+
+// Modeled worst case: 256 sections of 12 bytes plus allocator headers
+// is about 5KB, the AppMessage buffers take 760 bytes and the windows
+// and layers 1-2KB, so about 8KB; 12KB allows 50% on top of that.
+// The 24KB an app gets also holds its code and statics (sync.c alone
+// keeps about 1.3KB), so the real heap is smaller and is printed as
+// "heap" in every report. A budget above it is flagged as an overrun.
+#ifndef MEMSTATS_HEAP_USED_BUDGET
+#define MEMSTATS_HEAP_USED_BUDGET 12288
+#endif
+
+// Each move_apple() retry is a fresh random placement, so even with
+// half the board covered 32 misses in a row is a 1 in 4 billion event
+#ifndef MEMSTATS_APPLE_DEPTH_BUDGET
+#define MEMSTATS_APPLE_DEPTH_BUDGET 32
+#endif
+
+void *memstats_malloc(size_t size);
+void memstats_free(void *ptr);
+
+void memstats_enter_move_apple(void);
+void memstats_leave_move_apple(void);
+
+// Sampling updates the high-water marks, reporting also logs them
+void memstats_sample(void);
+void memstats_report(const char *label);
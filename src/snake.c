@@ -1,15 +1,21 @@
 #include <pebble.h>
 #include "game.h"
 #include "debrief.h"
+#include "sync.h"
+#include "memstats.h"
 
 static void init(void) {
+    sync_init();
     game_init();
     debrief_init();
+    memstats_report("init");
 }
 
 static void deinit(void) {
     game_deinit();
     debrief_deinit();
+    sync_deinit();
+    memstats_report("deinit");
 }
 
 int main(void) {
@@ -0,0 +1,285 @@
+#include <pebble.h>
+#include "sync.h"
+
+#define min(a,b) ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a < _b ? _a : _b; })
+
+// Keys must match appKeys in appinfo.json
+#define SYNC_KEY_RECORDS 0
+#define SYNC_KEY_RECORD_COUNT 1
+
+#define SYNC_INBOX_SIZE APP_MESSAGE_INBOX_SIZE_MINIMUM
+#define SYNC_OUTBOX_SIZE APP_MESSAGE_OUTBOX_SIZE_MINIMUM
+#define SYNC_QUEUE_SIZE 8
+#define SYNC_LOG_MAX 32
+#define SYNC_RETRY_MIN_INTERVAL 500
+#define SYNC_RETRY_MAX_INTERVAL 30000
+
+// Unsent records are persisted one per key on exit, in wire format
+#define SYNC_PERSIST_KEY_COUNT 100
+#define SYNC_PERSIST_KEY_RECORD 101
+
+// Wire format, little endian, records packed back to back:
+//   u16 score, u16 length, u16 duration (s), u8 flags, u8 log count,
+//   then log count * u16 input entries (2 bit input, 14 bit tick delta)
+// Duration and tick deltas both count unpaused game ticks only, so time
+// spent paused is excluded from both.
+#define SYNC_RECORD_HEADER_SIZE 8
+#define SYNC_FLAG_LOG_TRUNCATED 0x01
+#define SYNC_LOG_DELTA_MAX 0x3FFF
+
+typedef struct sync_record_t {
+    uint16_t score;
+    uint16_t length;
+    uint16_t duration;
+    uint8_t flags;
+    uint8_t log_count;
+    uint16_t log[SYNC_LOG_MAX];
+} sync_record_t;
+
+static sync_record_t queue[SYNC_QUEUE_SIZE];
+static unsigned queue_head;
+static unsigned queue_count;
+
+static sync_record_t current;
+static unsigned last_input_tick;
+
+static uint8_t outbox_blob[SYNC_OUTBOX_SIZE];
+static unsigned in_flight;
+static bool game_running;
+
+static AppTimer *retry_timer;
+static unsigned retry_interval = SYNC_RETRY_MIN_INTERVAL;
+
+//---------------------------------------------
+// Convenience Methods
+//---------------------------------------------
+
+static uint16_t clamp_u16(unsigned value)
+{
+    return value > UINT16_MAX ? UINT16_MAX : value;
+}
+
+static uint8_t *write_u16(uint8_t *out, uint16_t value)
+{
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+    return out + 2;
+}
+
+static uint16_t read_u16(const uint8_t *in)
+{
+    return in[0] | in[1] << 8;
+}
+
+static unsigned record_size(const sync_record_t *record)
+{
+    return SYNC_RECORD_HEADER_SIZE + 2*record->log_count;
+}
+
+static unsigned serialize_record(const sync_record_t *record, uint8_t *out)
+{
+    uint8_t *cursor = out;
+    cursor = write_u16(cursor, record->score);
+    cursor = write_u16(cursor, record->length);
+    cursor = write_u16(cursor, record->duration);
+    *cursor++ = record->flags;
+    *cursor++ = record->log_count;
+    for (unsigned i = 0; i < record->log_count; ++i) {
+        cursor = write_u16(cursor, record->log[i]);
+    }
+    return cursor - out;
+}
+
+static bool deserialize_record(sync_record_t *record, const uint8_t *in, unsigned size)
+{
+    if (size < SYNC_RECORD_HEADER_SIZE || in[7] > SYNC_LOG_MAX ||
+            size < SYNC_RECORD_HEADER_SIZE + 2u*in[7]) {
+        return false;
+    }
+    record->score = read_u16(in);
+    record->length = read_u16(in + 2);
+    record->duration = read_u16(in + 4);
+    record->flags = in[6];
+    record->log_count = in[7];
+    for (unsigned i = 0; i < record->log_count; ++i) {
+        record->log[i] = read_u16(in + SYNC_RECORD_HEADER_SIZE + 2*i);
+    }
+    return true;
+}
+
+//---------------------------------------------
+// Persistence
+//---------------------------------------------
+
+static void load_pending(void)
+{
+    if (!persist_exists(SYNC_PERSIST_KEY_COUNT)) {
+        return;
+    }
+    unsigned count = min((unsigned)persist_read_int(SYNC_PERSIST_KEY_COUNT), (unsigned)SYNC_QUEUE_SIZE);
+    for (unsigned i = 0; i < count; ++i) {
+        int size = persist_read_data(SYNC_PERSIST_KEY_RECORD + i, outbox_blob, sizeof(outbox_blob));
+        if (size > 0 && deserialize_record(&queue[queue_count], outbox_blob, size)) {
+            queue_count += 1;
+        }
+        persist_delete(SYNC_PERSIST_KEY_RECORD + i);
+    }
+    // Cleared so a crash before the next save cannot resend these
+    persist_delete(SYNC_PERSIST_KEY_COUNT);
+}
+
+static void save_pending(void)
+{
+    // Records still in flight have not been acknowledged, so keep them too
+    for (unsigned i = 0; i < queue_count; ++i) {
+        const sync_record_t *record = &queue[(queue_head + i) % SYNC_QUEUE_SIZE];
+        unsigned size = serialize_record(record, outbox_blob);
+        persist_write_data(SYNC_PERSIST_KEY_RECORD + i, outbox_blob, size);
+    }
+    persist_write_int(SYNC_PERSIST_KEY_COUNT, queue_count);
+}
+
+//---------------------------------------------
+// Outbox Queue
+//---------------------------------------------
+
+static void flush(void);
+
+static void retry_timer_callback(void *data)
+{
+    retry_timer = NULL;
+    flush();
+}
+
+static void schedule_retry(void)
+{
+    if (retry_timer) {
+        return;
+    }
+    retry_timer = app_timer_register(retry_interval, retry_timer_callback, NULL);
+    retry_interval = min(2*retry_interval, (unsigned)SYNC_RETRY_MAX_INTERVAL);
+}
+
+static void flush(void)
+{
+    // Never touch the radio during gameplay, and wait out any backoff
+    if (game_running || in_flight || retry_timer || queue_count == 0) {
+        return;
+    }
+
+    // Pack as many whole records as fit in a single dictionary
+    const unsigned capacity = SYNC_OUTBOX_SIZE - dict_calc_buffer_size(2, 0, sizeof(uint8_t));
+    unsigned blob_size = 0;
+    unsigned batch = 0;
+    while (batch < queue_count) {
+        const sync_record_t *record = &queue[(queue_head + batch) % SYNC_QUEUE_SIZE];
+        if (blob_size + record_size(record) > capacity) {
+            break;
+        }
+        blob_size += serialize_record(record, outbox_blob + blob_size);
+        batch += 1;
+    }
+
+    DictionaryIterator *iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+        schedule_retry();
+        return;
+    }
+    dict_write_data(iter, SYNC_KEY_RECORDS, outbox_blob, blob_size);
+    dict_write_uint8(iter, SYNC_KEY_RECORD_COUNT, batch);
+    dict_write_end(iter);
+
+    if (app_message_outbox_send() != APP_MSG_OK) {
+        schedule_retry();
+        return;
+    }
+    in_flight = batch;
+}
+
+static void outbox_sent_handler(DictionaryIterator *sent, void *context)
+{
+    queue_head = (queue_head + in_flight) % SYNC_QUEUE_SIZE;
+    queue_count -= in_flight;
+    in_flight = 0;
+    retry_interval = SYNC_RETRY_MIN_INTERVAL;
+    flush();
+}
+
+static void outbox_failed_handler(DictionaryIterator *failed, AppMessageResult reason, void *context)
+{
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Sync of %u records failed (%d), retrying in %ums", in_flight, reason, retry_interval);
+    in_flight = 0;
+    schedule_retry();
+}
+
+//---------------------------------------------
+// Game Records
+//---------------------------------------------
+
+void sync_set_game_running(bool running)
+{
+    game_running = running;
+    flush();
+}
+
+void sync_begin_game(void)
+{
+    memset(&current, 0, sizeof(current));
+    last_input_tick = 0;
+}
+
+void sync_log_input(unsigned tick, unsigned input)
+{
+    unsigned delta = tick - last_input_tick;
+    // Long gaps are bridged with empty (input 0) entries
+    while (delta > SYNC_LOG_DELTA_MAX && current.log_count < SYNC_LOG_MAX) {
+        current.log[current.log_count++] = SYNC_LOG_DELTA_MAX;
+        delta -= SYNC_LOG_DELTA_MAX;
+    }
+    if (current.log_count >= SYNC_LOG_MAX) {
+        current.flags |= SYNC_FLAG_LOG_TRUNCATED;
+        return;
+    }
+    current.log[current.log_count++] = (input & 0x3) << 14 | delta;
+    last_input_tick = tick;
+}
+
+void sync_end_game(unsigned score, unsigned length, unsigned duration_ms)
+{
+    current.score = clamp_u16(score);
+    current.length = clamp_u16(length);
+    current.duration = clamp_u16(duration_ms / 1000);
+
+    if (queue_count == SYNC_QUEUE_SIZE) {
+        APP_LOG(APP_LOG_LEVEL_WARNING, "Sync queue full, dropping game record");
+        return;
+    }
+    queue[(queue_head + queue_count) % SYNC_QUEUE_SIZE] = current;
+    queue_count += 1;
+    flush();
+}
+
+//---------------------------------------------
+// Program Init
+//---------------------------------------------
+
+void sync_init(void)
+{
+    app_message_register_outbox_sent(outbox_sent_handler);
+    app_message_register_outbox_failed(outbox_failed_handler);
+    app_message_open(SYNC_INBOX_SIZE, SYNC_OUTBOX_SIZE);
+    load_pending();
+}
+
+void sync_deinit(void)
+{
+    if (retry_timer) {
+        app_timer_cancel(retry_timer);
+        retry_timer = NULL;
+    }
+    if (queue_count) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "Saving %u unsynced game records", queue_count);
+        save_pending();
+    }
+    app_message_deregister_callbacks();
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <pebble.h>
+
+void sync_init(void);
+void sync_deinit(void);
+
+// Records are only sent to the phone while no game is running
+void sync_set_game_running(bool running);
+
+void sync_begin_game(void);
+void sync_log_input(unsigned tick, unsigned input);
+void sync_end_game(unsigned score, unsigned length, unsigned duration_ms);
@@ -0,0 +1,53 @@
+// Feeds the bytes sync_test captured from the watch through the
+// companion's appmessage handler, so the C and JS wire formats
+// cannot drift apart.
+//
+// Usage: node decode_records_test.js <sync_messages.json>
+
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+var vm = require('vm');
+
+var fixture = JSON.parse(fs.readFileSync(process.argv[2], 'utf8'));
+
+var listeners = {};
+var storage = {};
+var context = {
+    console: { log: function() {} },
+    Date: Date,
+    JSON: JSON,
+    Pebble: {
+        addEventListener: function(type, listener) {
+            listeners[type] = listener;
+        }
+    },
+    localStorage: {
+        getItem: function(key) {
+            return storage.hasOwnProperty(key) ? storage[key] : null;
+        },
+        setItem: function(key, value) {
+            storage[key] = String(value);
+        }
+    }
+};
+
+var source = path.join(__dirname, '..', 'src', 'js', 'pebble-js-app.js');
+vm.runInNewContext(fs.readFileSync(source, 'utf8'), context, source);
+
+// Decoding straight from the watch's bytes
+var decoded = context.decodeRecords(fixture.bytes);
+assert.strictEqual(decoded.length, fixture.count);
+assert.deepStrictEqual(JSON.parse(JSON.stringify(decoded)), fixture.expected);
+
+// And through the appmessage handler into the stored history
+listeners.appmessage({ payload: { GAME_RECORDS: fixture.bytes, GAME_RECORD_COUNT: fixture.count } });
+var history = JSON.parse(storage['snakey.games']);
+assert.strictEqual(history.length, fixture.count);
+history.forEach(function(record, i) {
+    assert.strictEqual(typeof record.received, 'number');
+    delete record.received;
+    assert.deepStrictEqual(record, fixture.expected[i]);
+});
+
+console.log('decode_records_test: ' + fixture.count + ' records, all passed');
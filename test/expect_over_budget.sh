@@ -0,0 +1,18 @@
+#!/bin/sh
+#
+# Usage: expect_over_budget.sh <test binary> <budget name>
+#
+# Passes only if the binary aborts on the named memstats budget.
+#
+
+log="$1.log"
+if "$1" > /dev/null 2> "$log"; then
+    echo "$1: expected the $2 budget to be exceeded" >&2
+    exit 1
+fi
+if ! grep -q "Memory budget exceeded: $2 " "$log"; then
+    echo "$1: did not fail on the $2 budget" >&2
+    cat "$log" >&2
+    exit 1
+fi
+echo "$1: failed on the $2 budget as expected"
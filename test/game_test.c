@@ -0,0 +1,132 @@
+// Plays a scripted game through src/game.c on the host. memstats.c is
+// built with SNAKEY_HOST_BUILD, so any sample over the budgets in
+// memstats.h aborts the run.
+
+#include <assert.h>
+#include "game.c"
+
+#define TARGET_LENGTH 40
+#define MAX_TICKS 2000
+
+// Horizontal rows turn around this far from the edges, leaving room
+// for the extra section added when an apple is eaten
+#define TURN_RIGHT_X 115
+#define TURN_LEFT_X 25
+
+static unsigned last_horizontal;
+
+//---------------------------------------------
+// Autopilot
+//---------------------------------------------
+
+// Sweeps the snake back and forth a row at a time so it never
+// crosses itself
+static void steer(void)
+{
+    snake_section_t *head = snake->head;
+    switch (snake->direction) {
+        case 0:
+            if (head->x >= TURN_RIGHT_X) {
+                last_horizontal = 0;
+                stub_click(BUTTON_ID_DOWN);
+            }
+            break;
+        case 2:
+            if (head->x <= TURN_LEFT_X) {
+                last_horizontal = 2;
+                stub_click(BUTTON_ID_UP);
+            }
+            break;
+        case 1:
+            stub_click(last_horizontal == 0 ? BUTTON_ID_DOWN : BUTTON_ID_UP);
+            break;
+    }
+}
+
+// Puts the apple where the head lands next tick if it keeps going
+static void feed(void)
+{
+    if (game->queued_input || (snake->direction != 0 && snake->direction != 2)) {
+        return;
+    }
+    float step = 2*SNAKE_BODY_WIDTH + SNAKE_BODY_SPACING;
+    apple->x = snake->head->x + (snake->direction == 0 ? step : -step);
+    apple->y = snake->head->y;
+}
+
+static void tick(void)
+{
+    stub_fire_timers();
+}
+
+//---------------------------------------------
+// Test
+//---------------------------------------------
+
+int main(void)
+{
+    // Same order as init() in snake.c
+    size_t baseline = heap_bytes_used();
+    sync_init();
+
+    // The AppMessage inbox and outbox live on the heap until the app
+    // exits; the SDK never frees them, so they are expected at deinit
+    size_t app_message_heap = heap_bytes_used() - baseline;
+    assert(app_message_heap >= APP_MESSAGE_INBOX_SIZE_MINIMUM + APP_MESSAGE_OUTBOX_SIZE_MINIMUM);
+
+    game_init();
+    debrief_init();
+    memstats_report("init");
+    srand(1);
+
+    assert(snake->length == DEFAULT_SNAKE_SIZE);
+
+    // Grow, sampling the budgets on every apple
+    unsigned ticks = 0;
+    while (snake->length < TARGET_LENGTH) {
+        steer();
+        feed();
+        tick();
+        assert(game->alive);
+        assert(++ticks < MAX_TICKS);
+    }
+
+    // Wait for a clear stretch of row, then turn back into the body
+    while (snake->direction != 0 || snake->head->x > TURN_RIGHT_X - 40) {
+        steer();
+        tick();
+    }
+    for (unsigned i = 0; i < 3 && game->alive; ++i) {
+        stub_click(BUTTON_ID_DOWN);
+        tick();
+    }
+    assert(!game->alive);
+
+    // Dying ends the game, shows the debrief and syncs the record
+    unsigned score = game->score;
+    tick();
+    assert(game->is_resetting);
+    assert(stub_messages_sent() == 1);
+    const stub_message_t *message = stub_message(0);
+    assert(message->record_count == 1);
+    assert((message->records[0] | message->records[1] << 8) == score);
+    stub_outbox_ack();
+
+    // Back to a fresh game
+    stub_window_stack_pop();
+    assert(snake->length == DEFAULT_SNAKE_SIZE);
+    assert(game->alive);
+
+    // Exit as the event loop would: empty the stack, then deinit()
+    stub_window_stack_pop();
+    game_deinit();
+    debrief_deinit();
+    sync_deinit();
+    memstats_report("deinit");
+
+    // Everything but the AppMessage buffers has been freed
+    assert(heap_bytes_used() == baseline + app_message_heap);
+
+    printf("game_test: grew to %u in %u ticks, all passed\n", TARGET_LENGTH, ticks);
+    return 0;
+}
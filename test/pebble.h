@@ -0,0 +1,204 @@
+#pragma once
+
+// Host stand-in for the subset of the Pebble SDK used by src/.
+// Implemented in pebble_stubs.c; the stub_* functions let tests drive
+// timers, windows and AppMessage callbacks by hand.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//---------------------------------------------
+// Heap
+//---------------------------------------------
+
+// Allocations are routed through a simulated watch heap so that
+// heap_bytes_used()/heap_bytes_free() report something meaningful
+#define STUB_HEAP_SIZE 24576
+
+void *stub_malloc(size_t size);
+void stub_free(void *ptr);
+#define malloc stub_malloc
+#define free stub_free
+
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+
+//---------------------------------------------
+// Logging
+//---------------------------------------------
+
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARNING 50
+#define APP_LOG_LEVEL_INFO 100
+#define APP_LOG_LEVEL_DEBUG 200
+
+#define APP_LOG(level, ...) do { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } while (0)
+
+//---------------------------------------------
+// Timers
+//---------------------------------------------
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+void app_timer_cancel(AppTimer *timer);
+
+unsigned stub_timers_pending(void);
+uint32_t stub_timer_last_interval(void);
+void stub_fire_timers(void);
+
+//---------------------------------------------
+// Persistent Storage
+//---------------------------------------------
+
+bool persist_exists(uint32_t key);
+int32_t persist_read_int(uint32_t key);
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size);
+int persist_write_int(uint32_t key, int32_t value);
+int persist_write_data(uint32_t key, const void *data, size_t size);
+int persist_delete(uint32_t key);
+
+//---------------------------------------------
+// AppMessage
+//---------------------------------------------
+
+#define APP_MESSAGE_INBOX_SIZE_MINIMUM 124
+#define APP_MESSAGE_OUTBOX_SIZE_MINIMUM 636
+
+typedef enum {
+    APP_MSG_OK = 0,
+    APP_MSG_SEND_TIMEOUT = 2,
+    APP_MSG_SEND_REJECTED = 4,
+    APP_MSG_BUSY = 64
+} AppMessageResult;
+
+typedef struct DictionaryIterator DictionaryIterator;
+typedef void (*AppMessageOutboxSent)(DictionaryIterator *sent, void *context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator *failed, AppMessageResult reason, void *context);
+
+uint32_t dict_calc_buffer_size(const uint8_t tuple_count, ...);
+int dict_write_data(DictionaryIterator *iter, uint32_t key, const uint8_t *data, uint16_t size);
+int dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value);
+uint32_t dict_write_end(DictionaryIterator *iter);
+
+AppMessageResult app_message_open(uint32_t size_inbound, uint32_t size_outbound);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
+AppMessageResult app_message_outbox_send(void);
+void app_message_register_outbox_sent(AppMessageOutboxSent sent_callback);
+void app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback);
+void app_message_deregister_callbacks(void);
+
+// Every message handed to app_message_outbox_send()
+typedef struct stub_message_t {
+    unsigned size; // Whole dictionary, as dict_calc_buffer_size() counts it
+    uint8_t records[APP_MESSAGE_OUTBOX_SIZE_MINIMUM];
+    unsigned records_size;
+    unsigned record_count;
+} stub_message_t;
+
+#define STUB_MAX_MESSAGES 64
+
+unsigned stub_messages_sent(void);
+const stub_message_t *stub_message(unsigned index);
+void stub_outbox_ack(void);
+void stub_outbox_nack(AppMessageResult reason);
+
+//---------------------------------------------
+// Graphics
+//---------------------------------------------
+
+typedef struct GPoint { int16_t x; int16_t y; } GPoint;
+typedef struct GSize { int16_t w; int16_t h; } GSize;
+typedef struct GRect { GPoint origin; GSize size; } GRect;
+
+#define GPoint(x, y) ((GPoint){ (x), (y) })
+#define GRect(x, y, w, h) ((GRect){ { (x), (y) }, { (w), (h) } })
+
+typedef enum { GColorClear = -1, GColorBlack = 0, GColorWhite = 1 } GColor;
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight } GTextAlignment;
+
+typedef struct GContext GContext;
+typedef const char *GFont;
+
+#define FONT_KEY_GOTHIC_14 "gothic-14"
+#define FONT_KEY_GOTHIC_18_BOLD "gothic-18-bold"
+#define FONT_KEY_GOTHIC_24_BOLD "gothic-24-bold"
+#define FONT_KEY_BITHAM_42_LIGHT "bitham-42-light"
+
+GFont fonts_get_system_font(const char *font_key);
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+
+//---------------------------------------------
+// Layers
+//---------------------------------------------
+
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_mark_dirty(Layer *layer);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment);
+
+//---------------------------------------------
+// Windows and Buttons
+//---------------------------------------------
+
+typedef struct Window Window;
+typedef void (*WindowHandler)(Window *window);
+
+typedef struct WindowHandlers {
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+
+typedef enum { BUTTON_ID_BACK, BUTTON_ID_UP, BUTTON_ID_SELECT, BUTTON_ID_DOWN } ButtonId;
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+
+Window *window_create(void);
+void window_destroy(Window *window);
+Layer *window_get_root_layer(const Window *window);
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_fullscreen(Window *window, bool enabled);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_stack_push(Window *window, bool animated);
+
+// Pops the top window, unloading it and showing the one below
+void stub_window_stack_pop(void);
+// Runs the click handler the top window subscribed for a button
+void stub_click(ButtonId button_id);
+
+//---------------------------------------------
+// Vibes
+//---------------------------------------------
+
+void vibes_short_pulse(void);
+void vibes_double_pulse(void);
@@ -0,0 +1,538 @@
+#include <stdarg.h>
+#include <pebble.h>
+
+#undef malloc
+#undef free
+
+//---------------------------------------------
+// Heap
+//---------------------------------------------
+
+// Each block carries its size so frees can be accounted for
+typedef union stub_block_t {
+    size_t size;
+    long double align;
+} stub_block_t;
+
+static size_t heap_used;
+
+void *stub_malloc(size_t size)
+{
+    if (heap_used + sizeof(stub_block_t) + size > STUB_HEAP_SIZE) {
+        return NULL;
+    }
+    stub_block_t *block = malloc(sizeof(stub_block_t) + size);
+    block->size = size;
+    heap_used += sizeof(stub_block_t) + size;
+    return block + 1;
+}
+
+void stub_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    stub_block_t *block = (stub_block_t *)ptr - 1;
+    heap_used -= sizeof(stub_block_t) + block->size;
+    free(block);
+}
+
+size_t heap_bytes_used(void)
+{
+    return heap_used;
+}
+
+size_t heap_bytes_free(void)
+{
+    return STUB_HEAP_SIZE - heap_used;
+}
+
+//---------------------------------------------
+// Timers
+//---------------------------------------------
+
+#define STUB_MAX_TIMERS 16
+
+struct AppTimer {
+    bool active;
+    AppTimerCallback callback;
+    void *data;
+};
+
+static AppTimer timers[STUB_MAX_TIMERS];
+static uint32_t last_interval;
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data)
+{
+    for (unsigned i = 0; i < STUB_MAX_TIMERS; ++i) {
+        if (!timers[i].active) {
+            timers[i] = (AppTimer) { true, callback, callback_data };
+            last_interval = timeout_ms;
+            return &timers[i];
+        }
+    }
+    return NULL;
+}
+
+void app_timer_cancel(AppTimer *timer)
+{
+    timer->active = false;
+}
+
+unsigned stub_timers_pending(void)
+{
+    unsigned count = 0;
+    for (unsigned i = 0; i < STUB_MAX_TIMERS; ++i) {
+        count += timers[i].active;
+    }
+    return count;
+}
+
+uint32_t stub_timer_last_interval(void)
+{
+    return last_interval;
+}
+
+void stub_fire_timers(void)
+{
+    // Only timers pending now fire; ones they register wait for the next call
+    bool due[STUB_MAX_TIMERS];
+    for (unsigned i = 0; i < STUB_MAX_TIMERS; ++i) {
+        due[i] = timers[i].active;
+    }
+    for (unsigned i = 0; i < STUB_MAX_TIMERS; ++i) {
+        if (due[i] && timers[i].active) {
+            timers[i].active = false;
+            timers[i].callback(timers[i].data);
+        }
+    }
+}
+
+//---------------------------------------------
+// Persistent Storage
+//---------------------------------------------
+
+#define STUB_MAX_PERSIST 32
+#define STUB_PERSIST_DATA_MAX 256
+
+typedef struct stub_persist_t {
+    bool used;
+    uint32_t key;
+    uint8_t data[STUB_PERSIST_DATA_MAX];
+    size_t size;
+} stub_persist_t;
+
+static stub_persist_t persisted[STUB_MAX_PERSIST];
+
+static stub_persist_t *persist_find(uint32_t key, bool create)
+{
+    for (unsigned i = 0; i < STUB_MAX_PERSIST; ++i) {
+        if (persisted[i].used && persisted[i].key == key) {
+            return &persisted[i];
+        }
+    }
+    for (unsigned i = 0; create && i < STUB_MAX_PERSIST; ++i) {
+        if (!persisted[i].used) {
+            persisted[i].used = true;
+            persisted[i].key = key;
+            return &persisted[i];
+        }
+    }
+    return NULL;
+}
+
+bool persist_exists(uint32_t key)
+{
+    return persist_find(key, false) != NULL;
+}
+
+int32_t persist_read_int(uint32_t key)
+{
+    int32_t value = 0;
+    persist_read_data(key, &value, sizeof(value));
+    return value;
+}
+
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size)
+{
+    stub_persist_t *entry = persist_find(key, false);
+    if (!entry) {
+        return -1;
+    }
+    size_t size = entry->size < buffer_size ? entry->size : buffer_size;
+    memcpy(buffer, entry->data, size);
+    return size;
+}
+
+int persist_write_int(uint32_t key, int32_t value)
+{
+    return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_write_data(uint32_t key, const void *data, size_t size)
+{
+    stub_persist_t *entry = persist_find(key, true);
+    if (!entry || size > STUB_PERSIST_DATA_MAX) {
+        return -1;
+    }
+    memcpy(entry->data, data, size);
+    entry->size = size;
+    return size;
+}
+
+int persist_delete(uint32_t key)
+{
+    stub_persist_t *entry = persist_find(key, false);
+    if (entry) {
+        entry->used = false;
+    }
+    return 0;
+}
+
+//---------------------------------------------
+// AppMessage
+//---------------------------------------------
+
+// Same layout arithmetic as the SDK: a 1 byte dictionary header
+// and a 7 byte header per tuple
+#define STUB_DICT_HEADER_SIZE 1
+#define STUB_TUPLE_HEADER_SIZE 7
+
+struct DictionaryIterator {
+    stub_message_t message;
+};
+
+static DictionaryIterator outbox;
+static bool outbox_open;
+static bool outbox_in_flight;
+static uint32_t outbox_size;
+
+static stub_message_t messages[STUB_MAX_MESSAGES];
+static unsigned message_count;
+
+static AppMessageOutboxSent outbox_sent_callback;
+static AppMessageOutboxFailed outbox_failed_callback;
+
+uint32_t dict_calc_buffer_size(const uint8_t tuple_count, ...)
+{
+    uint32_t size = STUB_DICT_HEADER_SIZE;
+    va_list sizes;
+    va_start(sizes, tuple_count);
+    for (unsigned i = 0; i < tuple_count; ++i) {
+        size += STUB_TUPLE_HEADER_SIZE + va_arg(sizes, uint32_t);
+    }
+    va_end(sizes);
+    return size;
+}
+
+int dict_write_data(DictionaryIterator *iter, uint32_t key, const uint8_t *data, uint16_t size)
+{
+    memcpy(iter->message.records, data, size);
+    iter->message.records_size = size;
+    iter->message.size += STUB_TUPLE_HEADER_SIZE + size;
+    return 0;
+}
+
+int dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value)
+{
+    iter->message.record_count = value;
+    iter->message.size += STUB_TUPLE_HEADER_SIZE + sizeof(value);
+    return 0;
+}
+
+uint32_t dict_write_end(DictionaryIterator *iter)
+{
+    return iter->message.size;
+}
+
+AppMessageResult app_message_open(uint32_t size_inbound, uint32_t size_outbound)
+{
+    // The SDK allocates both buffers on the app heap
+    stub_malloc(size_inbound);
+    stub_malloc(size_outbound);
+    outbox_size = size_outbound;
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator)
+{
+    if (outbox_open || outbox_in_flight) {
+        return APP_MSG_BUSY;
+    }
+    memset(&outbox, 0, sizeof(outbox));
+    outbox.message.size = STUB_DICT_HEADER_SIZE;
+    outbox_open = true;
+    *iterator = &outbox;
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void)
+{
+    if (!outbox_open || outbox.message.size > outbox_size || message_count == STUB_MAX_MESSAGES) {
+        return APP_MSG_SEND_REJECTED;
+    }
+    messages[message_count++] = outbox.message;
+    outbox_open = false;
+    outbox_in_flight = true;
+    return APP_MSG_OK;
+}
+
+void app_message_register_outbox_sent(AppMessageOutboxSent sent_callback)
+{
+    outbox_sent_callback = sent_callback;
+}
+
+void app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback)
+{
+    outbox_failed_callback = failed_callback;
+}
+
+void app_message_deregister_callbacks(void)
+{
+    outbox_sent_callback = NULL;
+    outbox_failed_callback = NULL;
+}
+
+unsigned stub_messages_sent(void)
+{
+    return message_count;
+}
+
+const stub_message_t *stub_message(unsigned index)
+{
+    return &messages[index];
+}
+
+void stub_outbox_ack(void)
+{
+    outbox_in_flight = false;
+    if (outbox_sent_callback) {
+        outbox_sent_callback(&outbox, NULL);
+    }
+}
+
+void stub_outbox_nack(AppMessageResult reason)
+{
+    outbox_in_flight = false;
+    if (outbox_failed_callback) {
+        outbox_failed_callback(&outbox, reason, NULL);
+    }
+}
+
+//---------------------------------------------
+// Graphics
+//---------------------------------------------
+
+GFont fonts_get_system_font(const char *font_key)
+{
+    return font_key;
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {}
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {}
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {}
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {}
+
+//---------------------------------------------
+// Layers
+//---------------------------------------------
+
+// Watch screen, 144x168 with a 16px status bar unless fullscreen
+#define STUB_SCREEN_WIDTH 144
+#define STUB_SCREEN_HEIGHT 168
+#define STUB_STATUS_BAR_HEIGHT 16
+
+struct Layer {
+    GRect frame;
+    LayerUpdateProc update_proc;
+};
+
+struct TextLayer {
+    Layer layer;
+    const char *text;
+};
+
+Layer *layer_create(GRect frame)
+{
+    Layer *layer = stub_malloc(sizeof(Layer));
+    *layer = (Layer) { .frame = frame };
+    return layer;
+}
+
+void layer_destroy(Layer *layer)
+{
+    stub_free(layer);
+}
+
+GRect layer_get_bounds(const Layer *layer)
+{
+    return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+GRect layer_get_frame(const Layer *layer)
+{
+    return layer->frame;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc)
+{
+    layer->update_proc = update_proc;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {}
+void layer_mark_dirty(Layer *layer) {}
+
+TextLayer *text_layer_create(GRect frame)
+{
+    TextLayer *text_layer = stub_malloc(sizeof(TextLayer));
+    *text_layer = (TextLayer) { .layer = { .frame = frame } };
+    return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer)
+{
+    stub_free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer)
+{
+    return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text)
+{
+    text_layer->text = text;
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {}
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {}
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {}
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment) {}
+
+//---------------------------------------------
+// Windows and Buttons
+//---------------------------------------------
+
+#define STUB_MAX_WINDOWS 4
+
+struct Window {
+    Layer root_layer;
+    WindowHandlers handlers;
+    ClickConfigProvider click_config_provider;
+    ClickHandler click_handlers[BUTTON_ID_DOWN + 1];
+    bool fullscreen;
+    bool loaded;
+};
+
+static Window *window_stack[STUB_MAX_WINDOWS];
+static unsigned window_stack_size;
+static Window *configuring_window;
+
+static void window_unload_if_loaded(Window *window)
+{
+    if (window->loaded) {
+        window->loaded = false;
+        if (window->handlers.unload) {
+            window->handlers.unload(window);
+        }
+    }
+}
+
+static void window_appear(Window *window)
+{
+    if (!window->loaded) {
+        window->loaded = true;
+        int16_t height = STUB_SCREEN_HEIGHT - (window->fullscreen ? 0 : STUB_STATUS_BAR_HEIGHT);
+        window->root_layer.frame = GRect(0, 0, STUB_SCREEN_WIDTH, height);
+        if (window->click_config_provider) {
+            configuring_window = window;
+            window->click_config_provider(NULL);
+            configuring_window = NULL;
+        }
+        if (window->handlers.load) {
+            window->handlers.load(window);
+        }
+    }
+    if (window->handlers.appear) {
+        window->handlers.appear(window);
+    }
+}
+
+static void window_disappear(Window *window)
+{
+    if (window->handlers.disappear) {
+        window->handlers.disappear(window);
+    }
+}
+
+Window *window_create(void)
+{
+    Window *window = stub_malloc(sizeof(Window));
+    memset(window, 0, sizeof(Window));
+    return window;
+}
+
+void window_destroy(Window *window)
+{
+    window_unload_if_loaded(window);
+    stub_free(window);
+}
+
+Layer *window_get_root_layer(const Window *window)
+{
+    return (Layer *)&window->root_layer;
+}
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider)
+{
+    window->click_config_provider = click_config_provider;
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers)
+{
+    window->handlers = handlers;
+}
+
+void window_set_fullscreen(Window *window, bool enabled)
+{
+    window->fullscreen = enabled;
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler)
+{
+    configuring_window->click_handlers[button_id] = handler;
+}
+
+void window_stack_push(Window *window, bool animated)
+{
+    if (window_stack_size > 0) {
+        window_disappear(window_stack[window_stack_size - 1]);
+    }
+    window_stack[window_stack_size++] = window;
+    window_appear(window);
+}
+
+void stub_window_stack_pop(void)
+{
+    Window *window = window_stack[--window_stack_size];
+    window_disappear(window);
+    window_unload_if_loaded(window);
+    if (window_stack_size > 0) {
+        window_appear(window_stack[window_stack_size - 1]);
+    }
+}
+
+void stub_click(ButtonId button_id)
+{
+    Window *window = window_stack[window_stack_size - 1];
+    if (window->click_handlers[button_id]) {
+        window->click_handlers[button_id](NULL, NULL);
+    }
+}
+
+//---------------------------------------------
+// Vibes
+//---------------------------------------------
+
+void vibes_short_pulse(void) {}
+void vibes_double_pulse(void) {}
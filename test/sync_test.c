@@ -0,0 +1,231 @@
+// Drives src/sync.c against the stubbed AppMessage outbox, standing in
+// for the phone. Writes the bytes the watch sent to the JSON file given
+// as argv[1] so decode_records_test.js can check the companion decodes
+// the same records.
+
+#include <assert.h>
+#include "sync.c"
+
+// Wire size of a record with the given number of log entries
+#define RECORD_BYTES(log_count) (SYNC_RECORD_HEADER_SIZE + 2*(log_count))
+
+//---------------------------------------------
+// Fixture Output
+//---------------------------------------------
+
+typedef struct expected_input_t {
+    unsigned tick;
+    unsigned input;
+} expected_input_t;
+
+typedef struct expected_record_t {
+    unsigned score;
+    unsigned length;
+    unsigned duration;
+    bool log_truncated;
+    unsigned input_count;
+    expected_input_t inputs[SYNC_LOG_MAX];
+} expected_record_t;
+
+static expected_record_t expected[SYNC_QUEUE_SIZE];
+static unsigned expected_count;
+
+static expected_record_t *expect_record(unsigned score, unsigned length, unsigned duration)
+{
+    expected_record_t *record = &expected[expected_count++];
+    *record = (expected_record_t) { score, length, duration };
+    return record;
+}
+
+static void write_fixture(const char *path, const stub_message_t *message)
+{
+    FILE *out = fopen(path, "w");
+    assert(out);
+    fprintf(out, "{\n  \"count\": %u,\n  \"bytes\": [", message->record_count);
+    for (unsigned i = 0; i < message->records_size; ++i) {
+        fprintf(out, "%s%u", i ? ", " : "", message->records[i]);
+    }
+    fprintf(out, "],\n  \"expected\": [\n");
+    for (unsigned i = 0; i < expected_count; ++i) {
+        const expected_record_t *record = &expected[i];
+        fprintf(out, "    { \"score\": %u, \"length\": %u, \"duration\": %u, \"logTruncated\": %s, \"inputs\": [",
+                record->score, record->length, record->duration, record->log_truncated ? "true" : "false");
+        for (unsigned j = 0; j < record->input_count; ++j) {
+            fprintf(out, "%s{ \"tick\": %u, \"input\": %u }", j ? ", " : "",
+                    record->inputs[j].tick, record->inputs[j].input);
+        }
+        fprintf(out, "] }%s\n", i + 1 < expected_count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+}
+
+//---------------------------------------------
+// Tests
+//---------------------------------------------
+
+// Games finished during play are held back, then go out as one batch
+static void test_batches_records_after_game(const char *fixture_path)
+{
+    sync_set_game_running(true);
+
+    // A short log
+    expected_record_t *record = expect_record(12, 8, 30);
+    const unsigned ticks[] = { 3, 7, 8, 20, 21 };
+    sync_begin_game();
+    for (unsigned i = 0; i < 5; ++i) {
+        sync_log_input(ticks[i], 1 + i % 3);
+        record->inputs[record->input_count++] = (expected_input_t) { ticks[i], 1 + i % 3 };
+    }
+    sync_end_game(12, 8, 30000);
+    assert(stub_messages_sent() == 0);
+
+    // A log that overflows SYNC_LOG_MAX entries
+    record = expect_record(150, 40, 95);
+    record->log_truncated = true;
+    sync_begin_game();
+    for (unsigned tick = 1; tick <= SYNC_LOG_MAX + 8; ++tick) {
+        sync_log_input(tick, 1 + tick % 2);
+        if (tick <= SYNC_LOG_MAX) {
+            record->inputs[record->input_count++] = (expected_input_t) { tick, 1 + tick % 2 };
+        }
+    }
+    sync_end_game(150, 40, 95400);
+    assert(stub_messages_sent() == 0);
+
+    // A gap too long for one entry is bridged with an empty one
+    record = expect_record(0, 3, 2000);
+    sync_begin_game();
+    sync_log_input(20000, 3);
+    record->inputs[record->input_count++] = (expected_input_t) { 20000, 3 };
+    sync_end_game(0, 3, 2000000);
+    assert(stub_messages_sent() == 0);
+    assert(stub_timers_pending() == 0);
+
+    sync_set_game_running(false);
+    assert(stub_messages_sent() == 1);
+
+    const stub_message_t *message = stub_message(0);
+    assert(message->record_count == 3);
+    assert(message->records_size == RECORD_BYTES(5) + RECORD_BYTES(SYNC_LOG_MAX) + RECORD_BYTES(2));
+    assert(message->size == dict_calc_buffer_size(2, message->records_size, sizeof(uint8_t)));
+    assert(message->size <= SYNC_OUTBOX_SIZE);
+
+    // Second record's header sits after the first record
+    const uint8_t *second = message->records + RECORD_BYTES(5);
+    assert(second[6] == SYNC_FLAG_LOG_TRUNCATED);
+    assert(second[7] == SYNC_LOG_MAX);
+    assert(message->records[6] == 0);
+
+    write_fixture(fixture_path, message);
+
+    stub_outbox_ack();
+    assert(queue_count == 0);
+    assert(stub_messages_sent() == 1);
+}
+
+// A full queue of maximum size records still fits one message
+static void test_full_queue_fits_one_message(void)
+{
+    unsigned sent = stub_messages_sent();
+    sync_set_game_running(true);
+    for (unsigned game = 0; game < SYNC_QUEUE_SIZE + 2; ++game) {
+        sync_begin_game();
+        for (unsigned tick = 1; tick <= SYNC_LOG_MAX; ++tick) {
+            sync_log_input(tick, 1);
+        }
+        sync_end_game(game, 3, 1000);
+    }
+    assert(queue_count == SYNC_QUEUE_SIZE);
+
+    sync_set_game_running(false);
+    assert(stub_messages_sent() == sent + 1);
+    const stub_message_t *message = stub_message(sent);
+    assert(message->record_count == SYNC_QUEUE_SIZE);
+    assert(message->records_size == SYNC_QUEUE_SIZE*RECORD_BYTES(SYNC_LOG_MAX));
+    assert(message->size <= SYNC_OUTBOX_SIZE);
+
+    stub_outbox_ack();
+    assert(queue_count == 0);
+}
+
+// NACKs back off from 500ms to a 30s cap, and retries wait out gameplay
+static void test_retry_backoff(void)
+{
+    const uint32_t intervals[] = { 500, 1000, 2000, 4000, 8000, 16000, 30000, 30000 };
+    unsigned sent = stub_messages_sent();
+
+    sync_begin_game();
+    sync_end_game(5, 4, 10000);
+    assert(stub_messages_sent() == sent + 1);
+
+    for (unsigned i = 0; i < sizeof(intervals)/sizeof(intervals[0]); ++i) {
+        stub_outbox_nack(APP_MSG_SEND_TIMEOUT);
+        assert(stub_timers_pending() == 1);
+        assert(stub_timer_last_interval() == intervals[i]);
+        assert(stub_messages_sent() == sent + 1 + i);
+
+        stub_fire_timers();
+        assert(stub_messages_sent() == sent + 2 + i);
+    }
+    sent = stub_messages_sent();
+
+    // No retry goes out while a game is running
+    stub_outbox_nack(APP_MSG_SEND_TIMEOUT);
+    sync_set_game_running(true);
+    stub_fire_timers();
+    assert(stub_messages_sent() == sent);
+
+    sync_set_game_running(false);
+    assert(stub_messages_sent() == sent + 1);
+    stub_outbox_ack();
+    assert(queue_count == 0);
+    assert(retry_interval == SYNC_RETRY_MIN_INTERVAL);
+}
+
+// Records left unsent on exit come back on the next launch
+static void test_persists_pending_records(void)
+{
+    unsigned sent = stub_messages_sent();
+    sync_set_game_running(true);
+    for (unsigned game = 0; game < 3; ++game) {
+        sync_begin_game();
+        sync_log_input(10 + game, 2);
+        sync_end_game(100 + game, 5, 1000);
+    }
+    sync_deinit();
+
+    memset(queue, 0, sizeof(queue));
+    queue_head = 0;
+    queue_count = 0;
+
+    sync_init();
+    assert(queue_count == 3);
+    for (unsigned game = 0; game < 3; ++game) {
+        assert(queue[game].score == 100 + game);
+        assert(queue[game].log_count == 1);
+        assert(queue[game].log[0] == (2 << 14 | (10 + game)));
+    }
+    assert(!persist_exists(SYNC_PERSIST_KEY_COUNT));
+    assert(stub_messages_sent() == sent);
+
+    sync_set_game_running(false);
+    assert(stub_messages_sent() == sent + 1);
+    assert(stub_message(sent)->record_count == 3);
+    stub_outbox_ack();
+}
+
+int main(int argc, char **argv)
+{
+    assert(argc == 2);
+
+    sync_init();
+    test_batches_records_after_game(argv[1]);
+    test_full_queue_fits_one_message();
+    test_retry_backoff();
+    test_persists_pending_records();
+    sync_deinit();
+
+    printf("sync_test: %u messages, all passed\n", stub_messages_sent());
+    return 0;
+}